@@ -372,6 +372,19 @@ class DAOPTION(object):
         ## },
         self.fvSource = {}
 
+        ## Restrict the actuator fvSource computation to the cells where the smoothing kernels
+        ## are larger than tolerance. The cells are found using the mesh cell octree and are cached
+        ## between time steps. They are updated only if the actuator parameters change or the mesh
+        ## moves. Setting active to False loops over all the mesh cells
+        self.fvSourceCellSearch = {"active": True, "tolerance": 1.0e-14}
+
+        ## The machine learning model used in the kOmegaSSTFIML turbulence model. The backend can be
+        ## tensorflow (reads kOmegaSSTFIML.pb, needs DAFoam to be compiled with TensorFlow), mlp
+        ## (the built-in dense network, reads the weights from kOmegaSSTFIML.mlp and can be used
+        ## with the AD builds), or auto (tensorflow if available, otherwise mlp). If benchmark is
+        ## True, all the available backends are evaluated and timed in the first residual call
+        self.fimlModel = {"backend": "auto", "benchmark": False}
+
         ## The adjoint equation solution method. Options are: Krylov, fixedPoint, or fixedPointC
         self.adjEqnSolMethod = "Krylov"
 
@@ -429,6 +442,14 @@ class DAOPTION(object):
             "ACTL": 1.0e-2,
         }
 
+        ## The number of worker processes to evaluate the finite-difference perturbations of dRdW,
+        ## dRdWPC, dFdW, and dRdFFD in parallel. OpenFOAM is not thread-safe, so each worker is a
+        ## forked copy of the solver that evaluates every nWorkers-th color (or FFD point), and the
+        ## parent inserts all entries to the matrix at the end. The partial derivative matrices are
+        ## identical to those computed with one worker. The workers can not use MPI, so this is only
+        ## supported for serial runs and is ignored for parallel runs
+        self.adjPartDerivNWorkers = 1
+
         ## Which options to use to improve the adjoint equation convergence of transonic conditions
         ## This is used only for transonic solvers such as DARhoSimpleCFoam
         self.transonicPCOption = -1
@@ -436,7 +457,22 @@ class DAOPTION(object):
         ## Options for unsteady adjoint. mode can be hybridAdjoint or timeAccurateAdjoint
         ## Here nTimeInstances is the number of time instances and periodicity is the
         ## periodicity of flow oscillation (hybrid adjoint only)
-        self.unsteadyAdjoint = {"mode": "None", "nTimeInstances": -1, "periodicity": -1.0}
+        ## checkpointType sets where the states of all time instances are stored: memory or disk.
+        ## The disk option writes the states to a memory-mapped file in checkpointDir (the case
+        ## directory if None) and prefetches the previous instances during the reverse sweep.
+        ## The disk file is shared by the solver and AD solver objects, so the states are not
+        ## copied to the Python layer. checkpointTag names the file; it is set internally.
+        ## checkpointPrecision can be double or single; single halves the storage at the cost of
+        ## a ~1e-7 relative error in the primal states used by the adjoint
+        self.unsteadyAdjoint = {
+            "mode": "None",
+            "nTimeInstances": -1,
+            "periodicity": -1.0,
+            "checkpointType": "memory",
+            "checkpointPrecision": "double",
+            "checkpointDir": "None",
+            "checkpointTag": "None",
+        }
 
         ## At which iteration should we start the averaging of objective functions.
         ## This is only used for unsteady solvers
@@ -457,7 +493,12 @@ class DAOPTION(object):
         ## If reverse mode is used, the adjoint will be computed by a Jacobian free approach
         ## refer to: Kenway et al. Effective adjoint approach for computational fluid dynamics,
         ## Progress in Aerospace Science, 2019.
-        self.useAD = {"mode": "reverse", "dvName": "None", "seedIndex": -9999}
+        ## For the forward mode, forwardMethod can be primal or matrixFree. primal differentiates the
+        ## whole primal solver. matrixFree runs the primal without AD and then solves the linear
+        ## direct (tangent) equation dRdW * dWdX = -dRdX with GMRES, where the dRdW*v products are
+        ## computed by the forward-mode AD and only the dRdW preconditioner matrix is assembled, i.e.,
+        ## no full dRdW Jacobian is needed (nor its coloring if adjPCColoring is reduced)
+        self.useAD = {"mode": "reverse", "dvName": "None", "seedIndex": -9999, "forwardMethod": "primal"}
 
         ## Rigid body motion for dynamic mesh
         ## This option will be used in DAPimpleDyMFoam to simulate dynamicMesh motion
@@ -506,9 +547,44 @@ class DAOPTION(object):
         ## debugging the accuracy of partial computation, always set it to True
         self.adjUseColoring = True
 
+        ## The coloring used for the preconditioner matrices (e.g., dRdWTPC). Options are: full or reduced.
+        ## full reads the coloring computed for the full Jacobian (dRdWColoring_*.bin). reduced computes
+        ## the coloring for the reduced connectivity of the preconditioner (maxResConLv4JacPCMat) and saves
+        ## it to dRdWColoringPC_*.bin. The reduced coloring needs much fewer colors and does not
+        ## require running the coloring solver for the full Jacobian. However, the perturbed residuals
+        ## still use the full stencil, so the entries of columns that share a cut-off connectivity are
+        ## summed, and the PC is only an approximation of the truncated Jacobian. Check the GMRES
+        ## iteration counts printed by the linear solver when using it
+        self.adjPCColoring = "full"
+
+        ## Options for the distance 2 graph coloring of the partial derivative Jacobians.
+        ## method: heuristic or greedy. heuristic is the original method. greedy is
+        ## a parallel speculative first-fit coloring with conflict resolution, it typically needs
+        ## fewer colors and less time, and prints the number of colors, rounds, conflicts, and the
+        ## time for each phase. Because it gives a different coloring, the FD partial derivatives
+        ## may differ slightly from those computed with heuristic.
+        ## useCache: also save the coloring to *Coloring_nProcs_hash.bin, where hash is computed from
+        ## the Jacobian connectivity, and reuse it if the mesh, states, connectivity levels, and
+        ## decomposition are unchanged. The cache does not apply to different numbers of procs
+        ## because the face states on the processor boundaries depend on the decomposition.
+        ## Set method to greedy and useCache to True to opt in
+        self.adjColoringOption = {"method": "heuristic", "useCache": False}
+
+        ## Options for the built-in profiler that records the time (per-rank and min/max/avg) for the
+        ## primal and adjoint phases, e.g., solvePrimal, calcdRdWT, the residual evaluation, the BC
+        ## correction, the tape recording and evaluation, the PC setup, and KSP iterations. The timers
+        ## are nested, and counters such as the number of KSP iterations and the tape memory are
+        ## recorded for each timer. sampleMemory: also record the resident memory high-water mark
+        ## for the coarse phases. Call DASolver.writeProfiling("profiling.json") to export the data.
+        ## The profiler is off by default because every timed call pays for a name lookup
+        self.profilingOption = {"active": False, "sampleMemory": True}
+
         ## The Petsc options for solving the adjoint linear equation. These options should work for
         ## most of the case. If the adjoint does not converge, try to increase pcFillLevel to 2, or
-        ## try "jacMatReOrdering": "nd"
+        ## try "jacMatReOrdering": "nd". If useMultiRHS is True, we compute dFdW for all objective
+        ## functions first and then solve all the adjoint equations together. This records the
+        ## dRdWT AD tape only once for the matrix-free adjoint, instead of once per objective function.
+        ## useMultiRHS is not supported for timeAccurateAdjoint
         self.adjEqnOption = {
             "globalPCIters": 0,
             "asmOverlap": 1,
@@ -525,6 +601,7 @@ class DAOPTION(object):
             "printInfo": 1,
             "fpMaxIters": 1000,
             "dynAdjustTol": True,
+            "useMultiRHS": False,
         }
 
         ## Normalization for residuals. We should normalize all residuals!
@@ -1029,6 +1106,15 @@ class PYDAFOAM(object):
         if not self.getOption("useAD")["mode"] in ["fd", "reverse", "forward"]:
             raise Error("useAD->mode only supports fd, reverse, or forward!")
 
+        if not self.getOption("useAD")["forwardMethod"] in ["primal", "matrixFree"]:
+            raise Error("useAD->forwardMethod only supports primal or matrixFree!")
+
+        if not self.getOption("adjPCColoring") in ["full", "reduced"]:
+            raise Error("adjPCColoring only supports full or reduced!")
+
+        if not self.getOption("adjColoringOption")["method"] in ["greedy", "heuristic"]:
+            raise Error("adjColoringOption-method only supports greedy or heuristic!")
+
         # check time accurate adjoint
         if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
             if not self.getOption("useAD")["mode"] in ["forward", "reverse"]:
@@ -1071,6 +1157,58 @@ class PYDAFOAM(object):
 
         return
 
+    def writeProfiling(self, fileName="profiling.json"):
+        """
+        Print the profiling timers and counters to screen and write them to a JSON file.
+        The original and AD solvers are compiled as different libraries, so each of them
+        has its own profiler. Their data are saved in the "solver" and "solverAD" keys
+
+        Parameters
+        ----------
+        fileName : str
+            The name of the JSON file
+        """
+
+        import json
+
+        solverNames = ["solver"]
+        if hasattr(self, "solverAD"):
+            solverNames.append("solverAD")
+
+        # the temporary files are saved in the same folder as fileName
+        tmpFileNames = {}
+        for solverName in solverNames:
+            tmpFileNames[solverName] = os.path.join(
+                os.path.dirname(fileName), solverName + "_" + os.path.basename(fileName)
+            )
+
+        for solverName in solverNames:
+            solver = getattr(self, solverName)
+            solver.reportProfiling()
+            solver.writeProfilingJSON(tmpFileNames[solverName].encode())
+
+        self.comm.Barrier()
+
+        if self.comm.rank == 0:
+            allData = {}
+            for solverName in solverNames:
+                tmpFileName = tmpFileNames[solverName]
+                with open(tmpFileName, "r") as f:
+                    allData[solverName] = json.load(f)
+                os.remove(tmpFileName)
+            with open(fileName, "w") as f:
+                json.dump(allData, f, indent=4)
+
+        self.comm.Barrier()
+
+    def resetProfiling(self):
+        """
+        Clear the profiling timers and counters
+        """
+        self.solver.resetProfiling()
+        if hasattr(self, "solverAD"):
+            self.solverAD.resetProfiling()
+
     def calcPrimalResidualStatistics(self, mode):
         if self.getOption("useAD")["mode"] in ["forward", "reverse"]:
             self.solverAD.calcPrimalResidualStatistics(mode.encode())
@@ -1103,17 +1241,23 @@ class PYDAFOAM(object):
         if adjMode == "hybridAdjoint" or adjMode == "timeAccurateAdjoint":
             nTimeInstances = self.getOption("unsteadyAdjoint")["nTimeInstances"]
 
-        self.stateMat = PETSc.Mat().create(PETSc.COMM_WORLD)
-        self.stateMat.setSizes(((nLocalAdjointStates, None), (None, nTimeInstances)))
-        self.stateMat.setFromOptions()
-        self.stateMat.setPreallocationNNZ((nTimeInstances, nTimeInstances))
-        self.stateMat.setUp()
-
-        self.stateBCMat = PETSc.Mat().create(PETSc.COMM_WORLD)
-        self.stateBCMat.setSizes(((nLocalAdjointBoundaryStates, None), (None, nTimeInstances)))
-        self.stateBCMat.setFromOptions()
-        self.stateBCMat.setPreallocationNNZ((nTimeInstances, nTimeInstances))
-        self.stateBCMat.setUp()
+        if self.getOption("unsteadyAdjoint")["checkpointType"] == "disk":
+            # the solver and AD solver objects share the disk records, so we only
+            # pass empty mat handles to setTimeInstanceVar and keep no states here
+            self.stateMat = PETSc.Mat()
+            self.stateBCMat = PETSc.Mat()
+        else:
+            self.stateMat = PETSc.Mat().create(PETSc.COMM_WORLD)
+            self.stateMat.setSizes(((nLocalAdjointStates, None), (None, nTimeInstances)))
+            self.stateMat.setFromOptions()
+            self.stateMat.setPreallocationNNZ((nTimeInstances, nTimeInstances))
+            self.stateMat.setUp()
+
+            self.stateBCMat = PETSc.Mat().create(PETSc.COMM_WORLD)
+            self.stateBCMat.setSizes(((nLocalAdjointBoundaryStates, None), (None, nTimeInstances)))
+            self.stateBCMat.setFromOptions()
+            self.stateBCMat.setPreallocationNNZ((nTimeInstances, nTimeInstances))
+            self.stateBCMat.setUp()
 
         self.timeVec = PETSc.Vec().createSeq(nTimeInstances, bsize=1, comm=PETSc.COMM_SELF)
         self.timeIdxVec = PETSc.Vec().createSeq(nTimeInstances, bsize=1, comm=PETSc.COMM_SELF)
@@ -1904,11 +2048,15 @@ class PYDAFOAM(object):
         self.deletePrevPrimalSolTime()
 
         self.primalFail = 0
-        if self.getOption("useAD")["mode"] == "forward":
+        if self.getOption("useAD")["mode"] == "forward" and self.getOption("useAD")["forwardMethod"] == "primal":
             self.primalFail = self.solverAD.solvePrimal(self.xvVec, self.wVec)
         else:
             self.primalFail = self.solver.solvePrimal(self.xvVec, self.wVec)
 
+        if self.getOption("useAD")["mode"] == "forward" and self.getOption("useAD")["forwardMethod"] == "matrixFree":
+            if not self.primalFail:
+                self.solveForwardMatrixFree()
+
         if self.getOption("writeMinorIterations"):
             self.renameSolution(self.nSolvePrimals)
             self.writeDeformedFFDs(self.nSolvePrimals)
@@ -1917,6 +2065,64 @@ class PYDAFOAM(object):
 
         return
 
+    def solveForwardMatrixFree(self):
+        """
+        Compute the forward-mode AD total derivatives using the matrix-free direct (tangent) method.
+        We solve dRdW * dWdX = -dRdX * Xdot with GMRES, where the dRdW*v products are computed by
+        the forward-mode AD and dRdX * Xdot comes from the AD seeds defined in useAD. Only the
+        dRdW preconditioner matrix is assembled. The derivatives are saved in the same way as
+        the forward-mode AD primal, so they can be read by getForwardADDerivVal
+        """
+
+        Info("Running matrix-free direct solver %03d" % self.nSolvePrimals)
+
+        startTime = MPI.Wtime()
+
+        self.solverAD.initializedRdWMatrixFree(self.xvVec, self.wVec)
+
+        # the preconditioner is the non-transposed dRdWPC
+        dRdWPC = PETSc.Mat().create(PETSc.COMM_WORLD)
+        self.solver.calcdRdW(self.xvVec, self.wVec, 1, dRdWPC)
+        self.printMatInfo("dRdWPC", dRdWPC)
+        pcTime = MPI.Wtime()
+
+        ksp = PETSc.KSP().create(PETSc.COMM_WORLD)
+        self.solverAD.createMLRKSPMatrixFree(dRdWPC, ksp)
+
+        rhsVec = self.wVec.duplicate()
+        rhsVec.zeroEntries()
+        self.solverAD.getdRdWMatrixFreeRHS(rhsVec)
+
+        dWVec = self.wVec.duplicate()
+        dWVec.zeroEntries()
+        self.solverAD.solveLinearEqn(ksp, rhsVec, dWVec)
+        nIters = ksp.getIterationNumber()
+
+        self.solverAD.calcForwardADDerivMatrixFree(dWVec)
+        solveTime = MPI.Wtime()
+
+        ksp.destroy()
+        dRdWPC.destroy()
+        rhsVec.destroy()
+        dWVec.destroy()
+        self.solverAD.destroydRdWMatrixFree()
+
+        Info(
+            "Matrix-free direct solution: PC %.2f s, linear solution %.2f s, %d GMRES iterations with %s PC coloring"
+            % (pcTime - startTime, solveTime - pcTime, nIters, self.getOption("adjPCColoring"))
+        )
+
+        return
+
+    def printMatInfo(self, name, mat):
+        """
+        Print the number of nonzeros and the memory usage of a Petsc matrix, summed over
+        all processors. This can be used to compare the memory usage of the Jacobian matrices
+        """
+
+        info = mat.getInfo(PETSc.Mat.InfoType.GLOBAL_SUM)
+        Info("%s: %d nonzeros, %.2f MB" % (name, info["nz_used"], info["memory"] / 1024.0 / 1024.0))
+
     def solveAdjoint(self):
         """
         Run adjoint solver to compute the adjoint vector psiVec
@@ -1968,6 +2174,7 @@ class PYDAFOAM(object):
         if self.getOption("useAD")["mode"] == "fd":
             dRdWT = PETSc.Mat().create(PETSc.COMM_WORLD)
             self.solver.calcdRdWT(self.xvVec, self.wVec, 0, dRdWT)
+            self.printMatInfo("dRdWT", dRdWT)
         elif self.getOption("useAD")["mode"] == "reverse":
             self.solverAD.initializedRdWTMatrixFree(self.xvVec, self.wVec)
 
@@ -1978,6 +2185,7 @@ class PYDAFOAM(object):
             if self.nSolveAdjoints == 1 or (self.nSolveAdjoints - 1) % adjPCLag == 0:
                 self.dRdWTPC = PETSc.Mat().create(PETSc.COMM_WORLD)
                 self.solver.calcdRdWT(self.xvVec, self.wVec, 1, self.dRdWTPC)
+                self.printMatInfo("dRdWTPC", self.dRdWTPC)
 
         # Initialize the KSP object
         ksp = PETSc.KSP().create(PETSc.COMM_WORLD)
@@ -1989,37 +2197,40 @@ class PYDAFOAM(object):
         # loop over all objFunc, calculate dFdW, and solve the adjoint
         objFuncDict = self.getOption("objFunc")
         wSize = self.solver.getNLocalAdjointStates()
-        for objFuncName in objFuncDict:
-            if objFuncName in self.objFuncNames4Adj:
-                dFdW = PETSc.Vec().create(PETSc.COMM_WORLD)
-                dFdW.setSizes((wSize, PETSc.DECIDE), bsize=1)
-                dFdW.setFromOptions()
-                if self.getOption("useAD")["mode"] == "fd":
-                    self.solver.calcdFdW(self.xvVec, self.wVec, objFuncName.encode(), dFdW)
-                elif self.getOption("useAD")["mode"] == "reverse":
-                    self.solverAD.calcdFdWAD(self.xvVec, self.wVec, objFuncName.encode(), dFdW)
-
-                # if it is time accurate adjoint, add extra terms for dFdW
-                if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
-                    # first copy the vectors from previous residual time step level
-                    self.dR0dW0TPsi[objFuncName].copy(self.dR00dW0TPsi[objFuncName])
-                    self.dR0dW00TPsi[objFuncName].copy(self.dR00dW00TPsi[objFuncName])
-                    self.dRdW0TPsi[objFuncName].copy(self.dR0dW0TPsi[objFuncName])
-                    self.dRdW00TPsi[objFuncName].copy(self.dR0dW00TPsi[objFuncName])
-                    dFdW.axpy(-1.0, self.dR0dW0TPsi[objFuncName])
-                    dFdW.axpy(-1.0, self.dR00dW00TPsi[objFuncName])
-
-                # Initialize the adjoint vector psi and solve for it
-                if self.getOption("useAD")["mode"] == "fd":
-                    self.adjointFail = self.solver.solveLinearEqn(ksp, dFdW, self.adjVectors[objFuncName])
-                elif self.getOption("useAD")["mode"] == "reverse":
-                    self.adjointFail = self.solverAD.solveLinearEqn(ksp, dFdW, self.adjVectors[objFuncName])
-
-                if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
-                    self.solverAD.calcdRdWOldTPsiAD(1, self.adjVectors[objFuncName], self.dRdW0TPsi[objFuncName])
-                    self.solverAD.calcdRdWOldTPsiAD(2, self.adjVectors[objFuncName], self.dRdW00TPsi[objFuncName])
-
-                dFdW.destroy()
+        if self.getOption("adjEqnOption")["useMultiRHS"]:
+            self.solveAdjointMultiRHS(ksp)
+        else:
+            for objFuncName in objFuncDict:
+                if objFuncName in self.objFuncNames4Adj:
+                    dFdW = PETSc.Vec().create(PETSc.COMM_WORLD)
+                    dFdW.setSizes((wSize, PETSc.DECIDE), bsize=1)
+                    dFdW.setFromOptions()
+                    if self.getOption("useAD")["mode"] == "fd":
+                        self.solver.calcdFdW(self.xvVec, self.wVec, objFuncName.encode(), dFdW)
+                    elif self.getOption("useAD")["mode"] == "reverse":
+                        self.solverAD.calcdFdWAD(self.xvVec, self.wVec, objFuncName.encode(), dFdW)
+
+                    # if it is time accurate adjoint, add extra terms for dFdW
+                    if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
+                        # first copy the vectors from previous residual time step level
+                        self.dR0dW0TPsi[objFuncName].copy(self.dR00dW0TPsi[objFuncName])
+                        self.dR0dW00TPsi[objFuncName].copy(self.dR00dW00TPsi[objFuncName])
+                        self.dRdW0TPsi[objFuncName].copy(self.dR0dW0TPsi[objFuncName])
+                        self.dRdW00TPsi[objFuncName].copy(self.dR0dW00TPsi[objFuncName])
+                        dFdW.axpy(-1.0, self.dR0dW0TPsi[objFuncName])
+                        dFdW.axpy(-1.0, self.dR00dW00TPsi[objFuncName])
+
+                    # Initialize the adjoint vector psi and solve for it
+                    if self.getOption("useAD")["mode"] == "fd":
+                        self.adjointFail = self.solver.solveLinearEqn(ksp, dFdW, self.adjVectors[objFuncName])
+                    elif self.getOption("useAD")["mode"] == "reverse":
+                        self.adjointFail = self.solverAD.solveLinearEqn(ksp, dFdW, self.adjVectors[objFuncName])
+
+                    if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
+                        self.solverAD.calcdRdWOldTPsiAD(1, self.adjVectors[objFuncName], self.dRdW0TPsi[objFuncName])
+                        self.solverAD.calcdRdWOldTPsiAD(2, self.adjVectors[objFuncName], self.dRdW00TPsi[objFuncName])
+
+                    dFdW.destroy()
 
         ksp.destroy()
         if self.getOption("useAD")["mode"] == "fd":
@@ -2404,6 +2615,81 @@ class PYDAFOAM(object):
 
         return
 
+    def solveAdjointMultiRHS(self, ksp):
+        """
+        Compute dFdW for all objective functions and solve all the adjoint equations together.
+        For the matrix-free adjoint, the dRdWT AD tape is recorded only once and reused for all
+        the objective functions. The preconditioner is set up only once as well
+
+        Input:
+        ------
+        ksp: the KSP object that has been set up by createMLRKSP or createMLRKSPMatrixFree
+
+        Output:
+        -------
+        self.adjVectors: the dict contains the adjoint vectors for all objective functions
+
+        self.adjointFail: if any adjoint solution fails, assigns 1, otherwise 0
+        """
+
+        if self.getOption("unsteadyAdjoint")["mode"] == "timeAccurateAdjoint":
+            raise Error("adjEqnOption->useMultiRHS is not supported for timeAccurateAdjoint")
+
+        objFuncDict = self.getOption("objFunc")
+        objFuncNames = [name for name in objFuncDict if name in self.objFuncNames4Adj]
+        nRHS = len(objFuncNames)
+        if nRHS == 0:
+            return
+
+        wSize = self.solver.getNLocalAdjointStates()
+
+        # the columns of dFdWMat are dFdW for all objective functions, the columns of psiMat
+        # are the corresponding adjoint vectors
+        dFdWMat = PETSc.Mat().createDense(((wSize, PETSc.DECIDE), (PETSc.DECIDE, nRHS)), comm=PETSc.COMM_WORLD)
+        dFdWMat.setUp()
+        psiMat = PETSc.Mat().createDense(((wSize, PETSc.DECIDE), (PETSc.DECIDE, nRHS)), comm=PETSc.COMM_WORLD)
+        psiMat.setUp()
+        dFdWArray = dFdWMat.getDenseArray()
+        psiArray = psiMat.getDenseArray()
+
+        # compute dFdW for all objective functions first. NOTE: calcdFdWAD resets the global AD tape
+        # so we have to do it before recording the dRdWT tape in solveLinearEqnMultiRHS
+        dFdW = PETSc.Vec().create(PETSc.COMM_WORLD)
+        dFdW.setSizes((wSize, PETSc.DECIDE), bsize=1)
+        dFdW.setFromOptions()
+        for idxI, objFuncName in enumerate(objFuncNames):
+            if self.getOption("useAD")["mode"] == "fd":
+                self.solver.calcdFdW(self.xvVec, self.wVec, objFuncName.encode(), dFdW)
+            elif self.getOption("useAD")["mode"] == "reverse":
+                self.solverAD.calcdFdWAD(self.xvVec, self.wVec, objFuncName.encode(), dFdW)
+            dFdWArray[:, idxI] = dFdW.getArray()
+            # the current adjoint vectors are used as the initial guess if useNonZeroInitGuess is set
+            psiArray[:, idxI] = self.adjVectors[objFuncName].getArray()
+        dFdW.destroy()
+
+        dFdWMat.assemblyBegin()
+        dFdWMat.assemblyEnd()
+        psiMat.assemblyBegin()
+        psiMat.assemblyEnd()
+
+        # solve the adjoint equations for all the columns
+        if self.getOption("useAD")["mode"] == "fd":
+            self.adjointFail = self.solver.solveLinearEqnMultiRHS(ksp, dFdWMat, psiMat)
+        elif self.getOption("useAD")["mode"] == "reverse":
+            self.adjointFail = self.solverAD.solveLinearEqnMultiRHS(ksp, dFdWMat, psiMat)
+
+        # copy the solutions back to the adjoint vectors
+        psiArray = psiMat.getDenseArray()
+        for idxI, objFuncName in enumerate(objFuncNames):
+            self.adjVectors[objFuncName].setArray(psiArray[:, idxI])
+            self.adjVectors[objFuncName].assemblyBegin()
+            self.adjVectors[objFuncName].assemblyEnd()
+
+        dFdWMat.destroy()
+        psiMat.destroy()
+
+        return
+
     def mapdXvTodFFD(self, totalDerivXv):
         """
         Map the Xv derivative (volume derivative) to the FFD derivatives (design variables)
@@ -2586,6 +2872,10 @@ class PYDAFOAM(object):
         if self.solverInitialized == 1:
             raise Error("pyDAFoam: self._initSolver has been called! One shouldn't initialize solvers twice!")
 
+        # the solver and AD solver objects need to map the same checkpoint file, and
+        # different pyDAFoam objects in the same process need different files
+        self.setOption("unsteadyAdjoint", {"checkpointTag": "%d_%d" % (os.getpid(), id(self))})
+
         solverName = self.getOption("solverName")
         solverArg = solverName + " -python " + self.parallelFlag
         if solverName in self.solverRegistry["Incompressible"]:
@@ -0,0 +1,296 @@
+#!/usr/bin/env python
+"""
+This script exports the weights and biases of a trained dense network to the .mlp
+dictionary read by the mlp backend of the kOmegaSSTFIML model (see mlInferenceMLP.C).
+We support two input formats: a frozen TensorFlow graph (.pb) with the same input and
+output names as those used by the tensorflow backend, and a Keras model (.h5, .keras,
+or a SavedModel folder) made of Dense layers. The frozen graph is parsed by a minimal
+protobuf reader in this script, so TensorFlow is only needed for the Keras models
+
+Usage:
+
+    python dafoam_exportmlp.py kOmegaSSTFIML.pb kOmegaSSTFIML.mlp
+    This will read the frozen graph kOmegaSSTFIML.pb and write the weights to kOmegaSSTFIML.mlp
+
+    python dafoam_exportmlp.py model.h5 kOmegaSSTFIML.mlp
+    This will read the Keras model model.h5 and write the weights to kOmegaSSTFIML.mlp
+"""
+
+import os
+import sys
+import struct
+
+# the input and output names used by the tensorflow backend in mlInferenceTF.C
+inputName = "input_placeholder"
+outputName = "output_value/BiasAdd"
+
+# activation ops in a frozen graph and their names in the .mlp file
+activationOps = {"Tanh": "tanh", "Relu": "relu", "Sigmoid": "sigmoid"}
+
+
+def readProtoFields(buf):
+    """
+    Split a protobuf message into a list of (fieldNumber, wireType, value). We only need
+    this minimal reader to parse a frozen graph, so the .pb files can be exported without
+    TensorFlow. A varint value is returned as an int, a fixed 32 or 64 bit value and a
+    length-delimited value are returned as bytes
+    """
+
+    def readVarint(pos):
+        val = 0
+        shift = 0
+        while True:
+            byte = buf[pos]
+            pos += 1
+            val |= (byte & 0x7F) << shift
+            if byte < 0x80:
+                return val, pos
+            shift += 7
+
+    fields = []
+    pos = 0
+    while pos < len(buf):
+        tag, pos = readVarint(pos)
+        fieldNumber = tag >> 3
+        wireType = tag & 0x7
+        if wireType == 0:
+            val, pos = readVarint(pos)
+        elif wireType == 1:
+            val = buf[pos : pos + 8]
+            pos += 8
+        elif wireType == 2:
+            length, pos = readVarint(pos)
+            val = buf[pos : pos + length]
+            pos += length
+        elif wireType == 5:
+            val = buf[pos : pos + 4]
+            pos += 4
+        else:
+            print("Error: wire type %d is not supported!" % wireType)
+            exit(1)
+        fields.append((fieldNumber, wireType, val))
+    return fields
+
+
+def readTensor(buf):
+    """
+    Read a float or double TensorProto and return (shape, values), where values is a
+    flat list in row-major order
+    """
+
+    # the field numbers and dtypes are defined in tensorflow/core/framework/tensor.proto,
+    # tensor_shape.proto, and types.proto
+    dtype = 1
+    shape = []
+    content = b""
+    floatVals = []
+    for fieldNumber, wireType, val in readProtoFields(buf):
+        if fieldNumber == 1:
+            dtype = val
+        elif fieldNumber == 2:
+            for dimField, _, dimVal in readProtoFields(val):
+                if dimField == 2:
+                    size = 1
+                    for sizeField, _, sizeVal in readProtoFields(dimVal):
+                        if sizeField == 1:
+                            size = sizeVal
+                    shape.append(size)
+        elif fieldNumber == 4:
+            content = val
+        elif fieldNumber == 5 and dtype == 1:
+            fmt = "f" if wireType == 5 else "%df" % (len(val) // 4)
+            floatVals += list(struct.unpack("<" + fmt, val))
+        elif fieldNumber == 6 and dtype == 2:
+            fmt = "d" if wireType == 1 else "%dd" % (len(val) // 8)
+            floatVals += list(struct.unpack("<" + fmt, val))
+
+    if dtype not in [1, 2]:
+        print("Error: only float and double tensors are supported!")
+        exit(1)
+
+    size = 1
+    for dim in shape:
+        size *= dim
+
+    if len(content) > 0:
+        valSize = 4 if dtype == 1 else 8
+        values = list(struct.unpack("<%d%s" % (size, "f" if dtype == 1 else "d"), content[: size * valSize]))
+    elif len(floatVals) == size:
+        values = floatVals
+    elif len(floatVals) == 1:
+        # a single value is broadcast to the whole tensor
+        values = floatVals * size
+    else:
+        print("Error: the tensor values do not match its shape!")
+        exit(1)
+
+    return shape, values
+
+
+def readFrozenGraph(fileName):
+    """
+    Read the dense layers from a frozen graph. We start from the output node and walk
+    back to the input node. Each layer is a MatMul followed by a BiasAdd (or Add), and
+    optionally an activation op. Return a list of (activation, weights, biases), where
+    weights has a shape of nNeurons by nLayerInputs
+    """
+
+    with open(fileName, "rb") as f:
+        graphBuf = f.read()
+
+    # parse the NodeDef messages (GraphDef field 1), see tensorflow/core/framework/node_def.proto
+    nodes = {}
+    for fieldNumber, _, nodeBuf in readProtoFields(graphBuf):
+        if fieldNumber != 1:
+            continue
+        node = {"name": "", "op": "", "input": [], "attr": {}}
+        for nodeField, _, val in readProtoFields(nodeBuf):
+            if nodeField == 1:
+                node["name"] = val.decode()
+            elif nodeField == 2:
+                node["op"] = val.decode()
+            elif nodeField == 3:
+                node["input"].append(val.decode())
+            elif nodeField == 5:
+                # an attr map entry, key is field 1 and the AttrValue is field 2
+                key = ""
+                attr = {}
+                for entryField, _, entryVal in readProtoFields(val):
+                    if entryField == 1:
+                        key = entryVal.decode()
+                    elif entryField == 2:
+                        for attrField, _, attrVal in readProtoFields(entryVal):
+                            attr[attrField] = attrVal
+                node["attr"][key] = attr
+        nodes[node["name"]] = node
+
+    def getNode(name):
+        # skip the control inputs (^name) and the output index (name:0)
+        name = name.lstrip("^").split(":")[0]
+        node = nodes[name]
+        # skip the Identity nodes, e.g., the "read" node of a variable
+        while node["op"] == "Identity":
+            node = nodes[node["input"][0].lstrip("^").split(":")[0]]
+        return node
+
+    def getBoolAttr(node, key):
+        # the bool value is field 5 of AttrValue
+        return node["attr"].get(key, {}).get(5, 0) != 0
+
+    def splitConstInput(node):
+        # return the constant input (shape, values) and the other input of a two-input op
+        node0 = getNode(node["input"][0])
+        node1 = getNode(node["input"][1])
+        for constNode, otherNode in [(node1, node0), (node0, node1)]:
+            if constNode["op"] == "Const":
+                # the tensor value is field 8 of AttrValue
+                return readTensor(constNode["attr"]["value"][8]), otherNode
+        print("Error: %s has no constant input!" % node["name"])
+        exit(1)
+
+    if outputName not in nodes or inputName not in nodes:
+        print("Error: %s and %s are needed in %s!" % (inputName, outputName, fileName))
+        exit(1)
+
+    layers = []
+    activation = "linear"
+    node = nodes[outputName]
+    while node["name"] != inputName:
+        if node["op"] not in ["BiasAdd", "Add", "AddV2"]:
+            print("Error: expect a BiasAdd node but found %s (%s)!" % (node["name"], node["op"]))
+            exit(1)
+        (_, biases), node = splitConstInput(node)
+
+        if node["op"] != "MatMul":
+            print("Error: expect a MatMul node but found %s (%s)!" % (node["name"], node["op"]))
+            exit(1)
+        if getBoolAttr(node, "transpose_a"):
+            print("Error: transpose_a in %s is not supported!" % node["name"])
+            exit(1)
+        transposeB = getBoolAttr(node, "transpose_b")
+        (shape, values), node = splitConstInput(node)
+        nRows, nCols = shape
+        kernel = [values[i * nCols : (i + 1) * nCols] for i in range(nRows)]
+        # the kernel has a shape of nLayerInputs by nNeurons unless transpose_b is set
+        if not transposeB:
+            kernel = [list(col) for col in zip(*kernel)]
+
+        layers.insert(0, (activation, kernel, biases))
+
+        # the activation of the previous layer
+        activation = "linear"
+        if node["op"] in activationOps:
+            activation = activationOps[node["op"]]
+            node = getNode(node["input"][0])
+
+    return layers
+
+
+def readKerasModel(fileName):
+    """
+    Read the Dense layers from a Keras model. Return a list of (activation, weights, biases),
+    where weights has a shape of nNeurons by nLayerInputs
+    """
+
+    # TensorFlow is only needed for the Keras models
+    import tensorflow as tf
+
+    model = tf.keras.models.load_model(fileName, compile=False)
+
+    layers = []
+    for layer in model.layers:
+        if isinstance(layer, tf.keras.layers.InputLayer):
+            continue
+        if not isinstance(layer, tf.keras.layers.Dense):
+            print("Error: layer %s is not a Dense layer!" % layer.name)
+            exit(1)
+        activation = layer.activation.__name__
+        if activation not in ["linear", "tanh", "relu", "sigmoid"]:
+            print("Error: activation %s in layer %s is not supported!" % (activation, layer.name))
+            exit(1)
+        kernel, biases = layer.get_weights()
+        layers.append((activation, kernel.T.tolist(), biases.tolist()))
+
+    return layers
+
+
+def writeMLP(layers, fileName):
+    """
+    Write the layers to the .mlp dictionary
+    """
+
+    with open(fileName, "w") as f:
+        f.write("// dense network exported by dafoam_exportmlp.py\n")
+        f.write("layers\n(\n")
+        for activation, weights, biases in layers:
+            f.write("    {\n")
+            f.write("        activation %s;\n" % activation)
+            f.write("        weights\n        (\n")
+            for row in weights:
+                f.write("            (%s)\n" % " ".join("%.17g" % val for val in row))
+            f.write("        );\n")
+            f.write("        biases (%s);\n" % " ".join("%.17g" % val for val in biases))
+            f.write("    }\n")
+        f.write(");\n")
+
+
+if len(sys.argv) != 3:
+    print("Usage: python dafoam_exportmlp.py model.pb model.mlp")
+    exit(1)
+
+inputFileName = sys.argv[1]
+outputFileName = sys.argv[2]
+
+print("Exporting %s to %s ...." % (inputFileName, outputFileName))
+
+if inputFileName.endswith(".pb") and not os.path.isdir(inputFileName):
+    layers = readFrozenGraph(inputFileName)
+else:
+    layers = readKerasModel(inputFileName)
+
+for layerI, (activation, weights, biases) in enumerate(layers):
+    print("Layer %d: %d inputs, %d neurons, %s" % (layerI, len(weights[0]), len(weights), activation))
+
+writeMLP(layers, outputFileName)
+
+print("Exporting %s to %s Done!" % (inputFileName, outputFileName))
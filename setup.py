@@ -33,6 +33,7 @@ setup(
         "dafoam/scripts/dafoam_plot3d2tecplot.py",
         "dafoam/scripts/dafoam_plot3dtransform.py",
         "dafoam/scripts/dafoam_stltransform.py",
+        "dafoam/scripts/dafoam_exportmlp.py",
     ],
     install_requires=[
         "numpy>=1.16.4",
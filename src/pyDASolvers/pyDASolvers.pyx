@@ -22,14 +22,20 @@ cdef extern from "DASolvers.H" namespace "Foam":
         void initSolver()
         int solvePrimal(PetscVec, PetscVec)
         void calcdRdWT(PetscVec, PetscVec, int, PetscMat)
+        void calcdRdW(PetscVec, PetscVec, int, PetscMat)
         void calcdRdWTPsiAD(PetscVec, PetscVec, PetscVec, PetscVec)
         void initializedRdWTMatrixFree(PetscVec, PetscVec)
         void destroydRdWTMatrixFree()
+        void initializedRdWMatrixFree(PetscVec, PetscVec)
+        void destroydRdWMatrixFree()
+        void getdRdWMatrixFreeRHS(PetscVec)
+        void calcForwardADDerivMatrixFree(PetscVec)
         void calcdFdW(PetscVec, PetscVec, char *, PetscVec)
         void calcdFdWAD(PetscVec, PetscVec, char *, PetscVec)
         void createMLRKSP(PetscMat, PetscMat, PetscKSP)
         void createMLRKSPMatrixFree(PetscMat, PetscKSP)
         void solveLinearEqn(PetscKSP, PetscVec, PetscVec)
+        int solveLinearEqnMultiRHS(PetscKSP, PetscMat, PetscMat)
         void calcdRdBC(PetscVec, PetscVec, char *, PetscMat)
         void calcdFdBC(PetscVec, PetscVec, char *, char *, PetscVec)
         void calcdFdBCAD(PetscVec, PetscVec, char *, char *, PetscVec)
@@ -66,6 +72,9 @@ cdef extern from "DASolvers.H" namespace "Foam":
         double getObjFuncValue(char *)
         void getForces(PetscVec, PetscVec, PetscVec, PetscVec)
         void printAllOptions()
+        void reportProfiling()
+        void writeProfilingJSON(char *)
+        void resetProfiling()
         void updateDAOption(object)
         double getPrevPrimalSolTime()
         # functions for unit tests
@@ -143,6 +152,9 @@ cdef class pyDASolvers:
     def calcdRdWT(self, Vec xvVec, Vec wVec, isPC, Mat dRdWT):
         self._thisptr.calcdRdWT(xvVec.vec, wVec.vec, isPC, dRdWT.mat)
     
+    def calcdRdW(self, Vec xvVec, Vec wVec, isPC, Mat dRdW):
+        self._thisptr.calcdRdW(xvVec.vec, wVec.vec, isPC, dRdW.mat)
+    
     def calcdRdWTPsiAD(self, Vec xvVec, Vec wVec, Vec psi, Vec dRdWTPsi):
         self._thisptr.calcdRdWTPsiAD(xvVec.vec, wVec.vec, psi.vec, dRdWTPsi.vec)
     
@@ -152,6 +164,18 @@ cdef class pyDASolvers:
     def destroydRdWTMatrixFree(self):
         self._thisptr.destroydRdWTMatrixFree()
     
+    def initializedRdWMatrixFree(self, Vec xvVec, Vec wVec):
+        self._thisptr.initializedRdWMatrixFree(xvVec.vec, wVec.vec)
+    
+    def destroydRdWMatrixFree(self):
+        self._thisptr.destroydRdWMatrixFree()
+    
+    def getdRdWMatrixFreeRHS(self, Vec rhsVec):
+        self._thisptr.getdRdWMatrixFreeRHS(rhsVec.vec)
+    
+    def calcForwardADDerivMatrixFree(self, Vec dWVec):
+        self._thisptr.calcForwardADDerivMatrixFree(dWVec.vec)
+    
     def calcdFdW(self, Vec xvVec, Vec wVec, objFuncName, Vec dFdW):
         self._thisptr.calcdFdW(xvVec.vec, wVec.vec, objFuncName, dFdW.vec)
     
@@ -167,6 +191,9 @@ cdef class pyDASolvers:
     def solveLinearEqn(self, KSP myKSP, Vec rhsVec, Vec solVec):
         self._thisptr.solveLinearEqn(myKSP.ksp, rhsVec.vec, solVec.vec)
 
+    def solveLinearEqnMultiRHS(self, KSP myKSP, Mat rhsMat, Mat solMat):
+        return self._thisptr.solveLinearEqnMultiRHS(myKSP.ksp, rhsMat.mat, solMat.mat)
+
     def calcdRdBC(self, Vec xvVec, Vec wVec, designVarName, Mat dRdBC):
         self._thisptr.calcdRdBC(xvVec.vec, wVec.vec, designVarName, dRdBC.mat)
     
@@ -287,6 +314,15 @@ cdef class pyDASolvers:
     def printAllOptions(self):
         self._thisptr.printAllOptions()
 
+    def reportProfiling(self):
+        self._thisptr.reportProfiling()
+
+    def writeProfilingJSON(self, fileName):
+        self._thisptr.writeProfilingJSON(fileName)
+
+    def resetProfiling(self):
+        self._thisptr.resetProfiling()
+
     def updateDAOption(self, pyOptions):
         self._thisptr.updateDAOption(pyOptions)
     
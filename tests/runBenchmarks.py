@@ -0,0 +1,224 @@
+#!/usr/bin/env python
+"""
+Run the performance benchmarks for the primal and adjoint phases
+
+Usage:
+    mpirun -np 4 python runBenchmarks.py [fd|reverse] [refBenchmark.json]
+
+The NACA0012 case in input.tar.gz is solved with DASimpleFoam, the coloring,
+primal, and adjoint (FFD and AOA design variables) are computed, and the
+DAProfiler data (per-rank and min/max/avg time, counters, memory) are written to
+benchmarks/DASimpleFoam_<mode>_<gitCommit>.json. One summary line per run is
+appended to benchmarks/history.csv such that the numbers can be tracked
+across commits. If a reference json file is given, the max time of the
+top-level timers are compared with the reference.
+"""
+
+from mpi4py import MPI
+from dafoam import PYDAFOAM, optFuncs
+import sys
+import os
+import json
+import time
+import subprocess
+from pygeo import *
+from pyspline import *
+from idwarp import *
+import numpy as np
+
+gcomm = MPI.COMM_WORLD
+
+mode = "fd"
+refFile = None
+if len(sys.argv) > 1:
+    mode = sys.argv[1]
+if len(sys.argv) > 2:
+    refFile = os.path.abspath(sys.argv[2])
+
+if mode not in ["fd", "reverse"]:
+    print("mode: %s not supported! Options are: fd and reverse" % mode)
+    exit(1)
+
+benchmarkDir = os.path.abspath("./benchmarks")
+try:
+    gitCommit = subprocess.check_output(["git", "rev-parse", "--short", "HEAD"]).decode().strip()
+except Exception:
+    gitCommit = "unknown"
+
+if gcomm.rank == 0:
+    if not os.path.isdir(benchmarkDir):
+        os.mkdir(benchmarkDir)
+
+os.chdir("./input/NACA0012")
+
+if gcomm.rank == 0:
+    os.system("rm -rf 0 processor* *.bin")
+    os.system("cp -r 0.incompressible 0")
+    os.system("cp -r system.incompressible system")
+    os.system("cp -r constant/turbulenceProperties.sst constant/turbulenceProperties")
+
+U0 = 10.0
+p0 = 0.0
+k0 = 0.18
+omega0 = 1225.0
+A0 = 0.1
+alpha0 = 5.0
+
+aeroOptions = {
+    "solverName": "DASimpleFoam",
+    "designSurfaceFamily": "designSurface",
+    "designSurfaces": ["wing"],
+    "useAD": {"mode": mode},
+    "primalMinResTol": 1e-12,
+    "primalBC": {
+        "U0": {"variable": "U", "patches": ["inout"], "value": [U0, 0.0, 0.0]},
+        "p0": {"variable": "p", "patches": ["inout"], "value": [p0]},
+        "k0": {"variable": "k", "patches": ["inout"], "value": [k0]},
+        "omega0": {"variable": "omega", "patches": ["inout"], "value": [omega0]},
+        "useWallFunction": True,
+    },
+    "objFunc": {
+        "CD": {
+            "part1": {
+                "type": "force",
+                "source": "patchToFace",
+                "patches": ["wing"],
+                "directionMode": "parallelToFlow",
+                "alphaName": "alpha",
+                "scale": 1.0 / (0.5 * U0 * U0 * A0),
+                "addToAdjoint": True,
+            }
+        },
+        "CL": {
+            "part1": {
+                "type": "force",
+                "source": "patchToFace",
+                "patches": ["wing"],
+                "directionMode": "normalToFlow",
+                "alphaName": "alpha",
+                "scale": 1.0 / (0.5 * U0 * U0 * A0),
+                "addToAdjoint": True,
+            }
+        },
+    },
+    "normalizeStates": {"U": U0, "p": U0 * U0 / 2.0, "k": k0, "omega": omega0, "phi": 1.0},
+    "adjPartDerivFDStep": {"State": 1e-6, "FFD": 1e-3},
+    "adjEqnOption": {"gmresRelTol": 1.0e-10, "gmresAbsTol": 1.0e-15, "pcFillLevel": 1, "jacMatReOrdering": "rcm"},
+    "adjColoringOption": {"method": "greedy", "useCache": False},
+    "profilingOption": {"active": True, "sampleMemory": True},
+    "designVar": {
+        "shapey": {"designVarType": "FFD"},
+        "alpha": {"designVarType": "AOA", "patches": ["inout"], "flowAxis": "x", "normalAxis": "y"},
+    },
+}
+
+meshOptions = {
+    "gridFile": os.getcwd(),
+    "fileType": "OpenFOAM",
+    "symmetryPlanes": [[[0.0, 0.0, 0.0], [0.0, 0.0, 1.0]], [[0.0, 0.0, 0.1], [0.0, 0.0, 1.0]]],
+}
+
+FFDFile = "./FFD/wingFFD.xyz"
+DVGeo = DVGeometry(FFDFile)
+nTwists = DVGeo.addRefAxis("bodyAxis", xFraction=0.25, alignIndex="k")
+
+
+def alpha(val, geo):
+    aoa = val[0] * np.pi / 180.0
+    inletU = [float(U0 * np.cos(aoa)), float(U0 * np.sin(aoa)), 0]
+    DASolver.setOption("primalBC", {"U0": {"variable": "U", "patches": ["inout"], "value": inletU}})
+    DASolver.updateDAOption()
+
+
+pts = DVGeo.getLocalIndex(0)
+indexList = pts[1:4, 1, 0].flatten()
+PS = geo_utils.PointSelect("list", indexList)
+DVGeo.addLocalDV("shapey", lower=-1.0, upper=1.0, axis="y", scale=1.0, pointSelect=PS)
+DVGeo.addGlobalDV("alpha", [alpha0], alpha, lower=-10.0, upper=10.0, scale=1.0)
+
+DASolver = PYDAFOAM(options=aeroOptions, comm=gcomm)
+DASolver.setDVGeo(DVGeo)
+mesh = USMesh(options=meshOptions, comm=gcomm)
+DASolver.addFamilyGroup(DASolver.getOption("designSurfaceFamily"), DASolver.getOption("designSurfaces"))
+DASolver.setMesh(mesh)
+evalFuncs = []
+DASolver.setEvalFuncs(evalFuncs)
+
+optFuncs.DASolver = DASolver
+optFuncs.DVGeo = DVGeo
+optFuncs.evalFuncs = evalFuncs
+optFuncs.gcomm = gcomm
+
+# the wall time of each phase seen from Python, the detailed breakdown is in DAProfiler
+wallTimes = {}
+
+t0 = time.time()
+DASolver.runColoring()
+wallTimes["runColoring"] = time.time() - t0
+
+xDVs = DVGeo.getValues()
+t0 = time.time()
+funcs, fail = optFuncs.calcObjFuncValues(xDVs)
+wallTimes["primal"] = time.time() - t0
+
+t0 = time.time()
+funcsSens, fail = optFuncs.calcObjFuncSens(xDVs, funcs)
+wallTimes["adjoint"] = time.time() - t0
+
+caseName = "DASimpleFoam_%s" % mode
+jsonFile = os.path.join(benchmarkDir, "%s_%s.json" % (caseName, gitCommit))
+DASolver.writeProfiling(jsonFile)
+
+if gcomm.rank == 0:
+    with open(jsonFile, "r") as f:
+        data = json.load(f)
+    data["case"] = caseName
+    data["gitCommit"] = gitCommit
+    data["date"] = time.strftime("%Y-%m-%d %H:%M:%S")
+    data["nProcs"] = gcomm.size
+    data["wallTimes"] = wallTimes
+    data["funcs"] = {key: float(np.asarray(funcs[key]).flatten()[0]) for key in funcs if key != "fail"}
+    with open(jsonFile, "w") as f:
+        json.dump(data, f, indent=4)
+
+    # append one line to the history file
+    historyFile = os.path.join(benchmarkDir, "history.csv")
+    newFile = not os.path.isfile(historyFile)
+    with open(historyFile, "a") as f:
+        if newFile:
+            f.write("date,gitCommit,case,nProcs,runColoring,primal,adjoint,peakMemMB\n")
+        peakMem = 0.0
+        for solverName in ["solver", "solverAD"]:
+            if solverName in data:
+                peakMem = max(peakMem, data[solverName]["memory"]["peak_MB"]["max"])
+        f.write(
+            "%s,%s,%s,%d,%g,%g,%g,%g\n"
+            % (
+                data["date"],
+                gitCommit,
+                caseName,
+                gcomm.size,
+                wallTimes["runColoring"],
+                wallTimes["primal"],
+                wallTimes["adjoint"],
+                peakMem,
+            )
+        )
+
+    print("Benchmark data written to %s" % jsonFile)
+
+    # compare the max time of the top-level timers with the reference
+    if refFile is not None:
+        with open(refFile, "r") as f:
+            ref = json.load(f)
+        print("%-60s %12s %12s %8s" % ("timer", "ref (s)", "new (s)", "ratio"))
+        for solverName in ["solver", "solverAD"]:
+            if solverName not in data or solverName not in ref:
+                continue
+            for timerName, timer in data[solverName]["timers"].items():
+                if "/" in timerName or timerName not in ref[solverName]["timers"]:
+                    continue
+                tRef = ref[solverName]["timers"][timerName]["time"]["max"]
+                tNew = timer["time"]["max"]
+                ratio = tNew / tRef if tRef > 0 else 0.0
+                print("%-60s %12.4g %12.4g %8.3f" % (solverName + ":" + timerName, tRef, tNew, ratio))
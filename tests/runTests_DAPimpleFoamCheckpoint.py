@@ -0,0 +1,165 @@
+#!/usr/bin/env python
+"""
+Run Python tests for the memory and disk checkpoints of the unsteady adjoint
+"""
+
+from mpi4py import MPI
+from dafoam import PYDAFOAM, optFuncs
+import os
+from pygeo import *
+from pyspline import *
+from idwarp import *
+import numpy as np
+from testFuncs import *
+
+gcomm = MPI.COMM_WORLD
+
+os.chdir("./input/CurvedCubeHexMesh")
+
+if gcomm.rank == 0:
+    os.system("rm -rf 0 processor*")
+    os.system("cp -r 0.unsteady 0")
+    os.system("cp -r system/controlDict.unsteady system/controlDict")
+    os.system("cp -r system/fvSchemes.unsteady system/fvSchemes")
+    os.system("cp -r system/fvSolution.unsteady system/fvSolution")
+    os.system("cp -r constant/turbulenceProperties.safv3 constant/turbulenceProperties")
+
+replace_text_in_file("system/controlDict", "endTime         40;", "endTime         0.05;")
+
+# mesh warping parameters, users need to manually specify the symmetry plane
+meshOptions = {
+    "gridFile": os.getcwd(),
+    "fileType": "OpenFOAM",
+    # point and normal for the symmetry plane
+    "symmetryPlanes": [],
+}
+
+
+# optFuncs
+def setObjFuncsUnsteady(DASolver, funcs, evalFuncs):
+    nTimeInstances = DASolver.getOption("unsteadyAdjoint")["nTimeInstances"]
+    for func in evalFuncs:
+        avgObjVal = 0.0
+        for i in range(1, nTimeInstances):
+            avgObjVal += DASolver.getTimeInstanceObjFunc(i, func)
+        funcs[func] = avgObjVal
+
+    funcs["fail"] = False
+
+
+def setObjFuncsSensUnsteady(DASolver, funcs, funcsSensAllTimeInstances, funcsSensCombined):
+
+    for funcsSens in funcsSensAllTimeInstances:
+        for objFunc in funcsSens:
+            if objFunc != "fail":
+                funcsSensCombined[objFunc] = {}
+                for dv in funcsSens[objFunc]:
+                    funcsSensCombined[objFunc][dv] = np.zeros_like(funcsSens[objFunc][dv], dtype="d")
+
+    for funcsSens in funcsSensAllTimeInstances:
+        for objFunc in funcsSens:
+            if objFunc != "fail":
+                for dv in funcsSens[objFunc]:
+                    funcsSensCombined[objFunc][dv] += funcsSens[objFunc][dv]
+
+    funcsSensCombined["fail"] = False
+
+    return
+
+
+def runUnsteadyAdjoint(checkpointType):
+    """
+    Run the primal and the time-accurate adjoint with the given checkpointType
+    and return the objective function values and their derivatives
+    """
+
+    daOptions = {
+        "solverName": "DAPimpleFoam",
+        "designSurfaces": ["wallsbump"],
+        "printIntervalUnsteady": 100,
+        "useAD": {"mode": "reverse"},
+        "unsteadyAdjoint": {"mode": "timeAccurateAdjoint", "nTimeInstances": 6, "checkpointType": checkpointType},
+        "objFunc": {
+            "CD": {
+                "part1": {
+                    "type": "force",
+                    "source": "patchToFace",
+                    "patches": ["wallsbump"],
+                    "directionMode": "fixedDirection",
+                    "direction": [1.0, 0.0, 0.0],
+                    "scale": 1.0,
+                    "addToAdjoint": True,
+                }
+            },
+        },
+        "primalMinResTol": 1e-16,
+        "adjStateOrdering": "cell",
+        "adjEqnOption": {"pcFillLevel": 0, "jacMatReOrdering": "natural", "useNonZeroInitGuess": False},
+        "normalizeStates": {"U": 1.0, "p": 1.0, "nuTilda": 0.1, "phi": 1.0},
+        "adjPartDerivFDStep": {"State": 1e-7, "FFD": 1e-2},
+        "designVar": {},
+        "adjPCLag": 1000,
+    }
+
+    # DVGeo
+    DVGeo = DVGeometry("./FFD/bumpFFD.xyz")
+    # select points
+    pts = DVGeo.getLocalIndex(0)
+    indexList = pts[2, 1, 2].flatten()
+    PS = geo_utils.PointSelect("list", indexList)
+    # shape
+    DVGeo.addLocalDV("shapey", lower=-1.0, upper=1.0, axis="y", scale=1.0, pointSelect=PS)
+    daOptions["designVar"]["shapey"] = {"designVarType": "FFD"}
+
+    # DAFoam
+    DASolver = PYDAFOAM(options=daOptions, comm=gcomm)
+    DASolver.setDVGeo(DVGeo)
+    mesh = USMesh(options=meshOptions, comm=gcomm)
+    DASolver.addFamilyGroup(DASolver.getOption("designSurfaceFamily"), DASolver.getOption("designSurfaces"))
+    DASolver.printFamilyList()
+    DASolver.setMesh(mesh)
+    # set evalFuncs
+    evalFuncs = ["CD"]
+    DASolver.setEvalFuncs(evalFuncs)
+
+    # DVCon
+    DVCon = DVConstraints()
+    DVCon.setDVGeo(DVGeo)
+    [p0, v1, v2] = DASolver.getTriangulatedMeshSurface(groupName=DASolver.getOption("designSurfaceFamily"))
+    surf = [p0, v1, v2]
+    DVCon.setSurface(surf)
+
+    optFuncs.DASolver = DASolver
+    optFuncs.DVGeo = DVGeo
+    optFuncs.DVCon = DVCon
+    optFuncs.evalFuncs = evalFuncs
+    optFuncs.gcomm = gcomm
+    optFuncs.setObjFuncsUnsteady = setObjFuncsUnsteady
+    optFuncs.setObjFuncsSensUnsteady = setObjFuncsSensUnsteady
+
+    DASolver.runColoring()
+    xDV = DVGeo.getValues()
+    funcs, fail = optFuncs.calcObjFuncValuesUnsteady(xDV)
+    funcsSens, fail = optFuncs.calcObjFuncSensUnsteady(xDV, funcs)
+
+    return funcs, funcsSens
+
+
+funcsMemory, funcsSensMemory = runUnsteadyAdjoint("memory")
+funcsDisk, funcsSensDisk = runUnsteadyAdjoint("disk")
+
+# the disk checkpoint should give exactly the same derivatives as the memory checkpoint
+maxRelDiff = 0.0
+for dvName in funcsSensMemory["CD"]:
+    ref = np.asarray(funcsSensMemory["CD"][dvName])
+    new = np.asarray(funcsSensDisk["CD"][dvName])
+    relDiff = np.max(np.abs(new - ref) / (np.abs(ref) + 1e-16))
+    maxRelDiff = max(maxRelDiff, relDiff)
+
+if gcomm.rank == 0:
+    reg_write_dict(funcsDisk, 1e-8, 1e-10)
+    print("Max relative difference between the memory and disk checkpoint derivatives:")
+    reg_write(maxRelDiff, 1e-8, 1e-10)
+    if maxRelDiff > 1e-8:
+        print("disk checkpoint derivatives do not match the memory checkpoint!")
+        exit(1)
@@ -0,0 +1,170 @@
+#!/usr/bin/env python
+"""
+Run Python tests for DASimpleFoam with adjEqnOption->useMultiRHS: the total
+derivatives for all objectives should be the same as the ones from the
+default per-objective adjoint
+"""
+
+from mpi4py import MPI
+from dafoam import PYDAFOAM, optFuncs
+import sys
+import os
+from pygeo import *
+from pyspline import *
+from idwarp import *
+import numpy as np
+from testFuncs import *
+
+gcomm = MPI.COMM_WORLD
+
+os.chdir("./input/NACA0012")
+
+if gcomm.rank == 0:
+    os.system("rm -rf 0 processor*")
+    os.system("cp -r 0.incompressible 0")
+    os.system("cp -r system.incompressible system")
+    os.system("cp -r constant/turbulenceProperties.safv3 constant/turbulenceProperties")
+
+U0 = 10.0
+p0 = 0.0
+k0 = 0.18
+omega0 = 1225.0
+A0 = 0.1
+alpha0 = 5.0
+
+# test incompressible solvers
+aeroOptions = {
+    "solverName": "DASimpleFoam",
+    "designSurfaceFamily": "designSurface",
+    "designSurfaces": ["wing"],
+    "useAD": {"mode": "reverse"},
+    "primalMinResTol": 1e-12,
+    "primalBC": {
+        "U0": {"variable": "U", "patches": ["inout"], "value": [U0, 0.0, 0.0]},
+        "p0": {"variable": "p", "patches": ["inout"], "value": [p0]},
+        "k0": {"variable": "k", "patches": ["inout"], "value": [k0]},
+        "omega0": {"variable": "omega", "patches": ["inout"], "value": [omega0]},
+        "useWallFunction": True,
+    },
+    "objFunc": {
+        "CD": {
+            "part1": {
+                "type": "force",
+                "source": "patchToFace",
+                "patches": ["wing"],
+                "directionMode": "parallelToFlow",
+                "alphaName": "alpha",
+                "scale": 1.0 / (0.5 * U0 * U0 * A0),
+                "addToAdjoint": True,
+            }
+        },
+        "CL": {
+            "part1": {
+                "type": "force",
+                "source": "patchToFace",
+                "patches": ["wing"],
+                "directionMode": "normalToFlow",
+                "alphaName": "alpha",
+                "scale": 1.0 / (0.5 * U0 * U0 * A0),
+                "addToAdjoint": True,
+            }
+        },
+    },
+    "normalizeStates": {"U": U0, "p": U0 * U0 / 2.0, "k": k0, "omega": omega0, "phi": 1.0},
+    "adjEqnOption": {
+        "gmresRelTol": 1.0e-10,
+        "gmresAbsTol": 1.0e-15,
+        "pcFillLevel": 1,
+        "jacMatReOrdering": "rcm",
+        "useMultiRHS": False,
+    },
+    # Design variable setup
+    "designVar": {
+        "shapey": {"designVarType": "FFD"},
+        "alpha": {"designVarType": "AOA", "patches": ["inout"], "flowAxis": "x", "normalAxis": "y"},
+    },
+}
+
+# mesh warping parameters, users need to manually specify the symmetry plane
+meshOptions = {
+    "gridFile": os.getcwd(),
+    "fileType": "OpenFOAM",
+    # point and normal for the symmetry plane
+    "symmetryPlanes": [[[0.0, 0.0, 0.0], [0.0, 0.0, 1.0]], [[0.0, 0.0, 0.1], [0.0, 0.0, 1.0]]],
+}
+
+# DVGeo
+FFDFile = "./FFD/wingFFD.xyz"
+DVGeo = DVGeometry(FFDFile)
+
+# nTwists is the number of FFD points in the spanwise direction
+nTwists = DVGeo.addRefAxis("bodyAxis", xFraction=0.25, alignIndex="k")
+
+
+def alpha(val, geo):
+    aoa = val[0] * np.pi / 180.0
+    inletU = [float(U0 * np.cos(aoa)), float(U0 * np.sin(aoa)), 0]
+    DASolver.setOption("primalBC", {"U0": {"variable": "U", "patches": ["inout"], "value": inletU}})
+    DASolver.updateDAOption()
+
+
+# select points
+pts = DVGeo.getLocalIndex(0)
+indexList = pts[1:4, 1, 0].flatten()
+PS = geo_utils.PointSelect("list", indexList)
+DVGeo.addLocalDV("shapey", lower=-1.0, upper=1.0, axis="y", scale=1.0, pointSelect=PS)
+DVGeo.addGlobalDV("alpha", [alpha0], alpha, lower=-10.0, upper=10.0, scale=1.0)
+
+# DAFoam
+DASolver = PYDAFOAM(options=aeroOptions, comm=gcomm)
+DASolver.setDVGeo(DVGeo)
+mesh = USMesh(options=meshOptions, comm=gcomm)
+DASolver.addFamilyGroup(DASolver.getOption("designSurfaceFamily"), DASolver.getOption("designSurfaces"))
+DASolver.printFamilyList()
+DASolver.setMesh(mesh)
+# set evalFuncs
+evalFuncs = ["CD", "CL"]
+DASolver.setEvalFuncs(evalFuncs)
+
+# DVCon
+DVCon = DVConstraints()
+DVCon.setDVGeo(DVGeo)
+[p0, v1, v2] = DASolver.getTriangulatedMeshSurface(groupName=DASolver.getOption("designSurfaceFamily"))
+surf = [p0, v1, v2]
+DVCon.setSurface(surf)
+
+# optFuncs
+optFuncs.DASolver = DASolver
+optFuncs.DVGeo = DVGeo
+optFuncs.DVCon = DVCon
+optFuncs.evalFuncs = evalFuncs
+optFuncs.gcomm = gcomm
+
+# Run
+DASolver.runColoring()
+xDVs = DVGeo.getValues()
+funcs, fail = optFuncs.calcObjFuncValues(xDVs)
+
+# the default per-objective adjoint
+funcsSens, fail = optFuncs.calcObjFuncSens(xDVs, funcs)
+
+# solve all the adjoint equations together
+DASolver.setOption("adjEqnOption", {"useMultiRHS": True})
+DASolver.updateDAOption()
+funcsSensMultiRHS, fail = optFuncs.calcObjFuncSens(xDVs, funcs)
+
+# the max relative difference between the two adjoint paths
+maxRelDiff = 0.0
+for funcName in evalFuncs:
+    for dvName in xDVs:
+        ref = np.asarray(funcsSens[funcName][dvName])
+        new = np.asarray(funcsSensMultiRHS[funcName][dvName])
+        relDiff = np.max(np.abs(new - ref) / (np.abs(ref) + 1e-16))
+        maxRelDiff = max(maxRelDiff, relDiff)
+
+if gcomm.rank == 0:
+    print("Max relative difference between the per-objective and multi-RHS adjoint:")
+    reg_write(maxRelDiff, 1e-6, 1e-6)
+    if maxRelDiff > 1e-6:
+        print("multi-RHS adjoint does not match the per-objective adjoint!")
+        exit(1)
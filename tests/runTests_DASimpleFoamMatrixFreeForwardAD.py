@@ -0,0 +1,194 @@
+#!/usr/bin/env python
+"""
+Run Python tests for the matrix-free forward-mode AD of DASimpleFoam
+"""
+
+from mpi4py import MPI
+from dafoam import PYDAFOAM, optFuncs
+import sys
+import os
+from pygeo import *
+from pyspline import *
+from idwarp import *
+import numpy as np
+from testFuncs import *
+
+gcomm = MPI.COMM_WORLD
+
+os.chdir("./input/NACA0012")
+
+if gcomm.rank == 0:
+    os.system("rm -rf 0 processor*")
+    os.system("cp -r 0.incompressible 0")
+    os.system("cp -r system.incompressible system")
+    os.system("cp -r constant/turbulenceProperties.kw constant/turbulenceProperties")
+
+U0 = 10.0
+p0 = 0.0
+A0 = 0.1
+alpha0 = 3.0
+
+# test incompressible solvers
+daOptions = {
+    "solverName": "DASimpleFoam",
+    "designSurfaces": ["wing"],
+    "primalMinResTol": 1e-12,
+    "useAD": {"mode": "forward", "dvName": "shape", "seedIndex": 0, "forwardMethod": "primal"},
+    "primalBC": {
+        "U0": {"variable": "U", "patches": ["inout"], "value": [U0, 0.0, 0.0]},
+        "p0": {"variable": "p", "patches": ["inout"], "value": [0.0]},
+        "useWallFunction": False,
+    },
+    "fvSource": {
+        "disk1": {
+            "type": "actuatorDisk",
+            "source": "cylinderAnnulusSmooth",
+            "center": [-0.5, 0.0, 0.05],
+            "direction": [1.0, 0.0, 0.0],
+            "innerRadius": 0.01,
+            "outerRadius": 0.4,
+            "rotDir": "right",
+            "scale": 10.0,
+            "POD": 0.8,
+            "eps": 0.1,
+            "expM": 1.0,
+            "expN": 0.5,
+            "adjustThrust": 1,
+            "targetThrust": 0.2,
+        },
+    },
+    "objFunc": {
+        "CD": {
+            "part1": {
+                "type": "force",
+                "source": "patchToFace",
+                "patches": ["wing"],
+                "directionMode": "parallelToFlow",
+                "alphaName": "alpha",
+                "scale": 1.0 / (0.5 * U0 * U0 * A0),
+                "addToAdjoint": True,
+            }
+        },
+        "CL": {
+            "part1": {
+                "type": "force",
+                "source": "patchToFace",
+                "patches": ["wing"],
+                "directionMode": "normalToFlow",
+                "alphaName": "alpha",
+                "scale": 1.0 / (0.5 * U0 * U0 * A0),
+                "addToAdjoint": True,
+            }
+        },
+    },
+    "adjEqnOption": {"gmresRelTol": 1.0e-10, "gmresAbsTol": 1.0e-15, "pcFillLevel": 1, "jacMatReOrdering": "rcm"},
+    "normalizeStates": {"U": U0, "p": U0 * U0 / 2.0, "nuTilda": 1e-3, "phi": 1.0},
+    "adjPCColoring": "reduced",
+    "designVar": {},
+}
+
+# mesh warping parameters, users need to manually specify the symmetry plane
+meshOptions = {
+    "gridFile": os.getcwd(),
+    "fileType": "OpenFOAM",
+    # point and normal for the symmetry plane
+    "symmetryPlanes": [[[0.0, 0.0, 0.0], [0.0, 0.0, 1.0]], [[0.0, 0.0, 0.1], [0.0, 0.0, 1.0]]],
+}
+
+# DVGeo
+DVGeo = DVGeometry("./FFD/wingFFD.xyz")
+# nTwists is the number of FFD points in the spanwise direction
+nTwists = DVGeo.addRefAxis("bodyAxis", xFraction=0.25, alignIndex="k")
+
+
+def alpha(val, geo):
+    aoa = val[0] * np.pi / 180.0
+    inletU = [float(U0 * np.cos(aoa)), float(U0 * np.sin(aoa)), 0]
+    DASolver.setOption("primalBC", {"U0": {"variable": "U", "patches": ["inout"], "value": inletU}})
+    DASolver.updateDAOption()
+
+
+def pbc(val, geo):
+    pIn = float(val[0])
+    DASolver.setOption("primalBC", {"p0": {"variable": "p", "patches": ["inout"], "value": [pIn]}})
+    DASolver.updateDAOption()
+
+
+# select points
+pts = DVGeo.getLocalIndex(0)
+indexList = pts[1:4, 1, 0].flatten()
+PS = geo_utils.PointSelect("list", indexList)
+# shape
+DVGeo.addLocalDV("shape", lower=-1.0, upper=1.0, axis="y", scale=1.0, pointSelect=PS)
+daOptions["designVar"]["shape"] = {"designVarType": "FFD"}
+# AOA
+DVGeo.addGlobalDV("alpha", value=[alpha0], func=alpha, lower=0.0, upper=10.0, scale=1.0)
+daOptions["designVar"]["alpha"] = {"designVarType": "AOA", "patches": ["inout"], "flowAxis": "x", "normalAxis": "y"}
+# p BC
+DVGeo.addGlobalDV("pbc", [0.0], pbc, lower=-100.0, upper=100.0, scale=1.0)
+daOptions["designVar"]["pbc"] = {"designVarType": "BC", "patches": ["inout"], "variable": "p", "comp": 0}
+
+# DAFoam
+DASolver = PYDAFOAM(options=daOptions, comm=gcomm)
+DASolver.setDVGeo(DVGeo)
+mesh = USMesh(options=meshOptions, comm=gcomm)
+DASolver.addFamilyGroup(DASolver.getOption("designSurfaceFamily"), DASolver.getOption("designSurfaces"))
+DASolver.printFamilyList()
+DASolver.setMesh(mesh)
+# set evalFuncs
+evalFuncs = []
+DASolver.setEvalFuncs(evalFuncs)
+
+# DVCon
+DVCon = DVConstraints()
+DVCon.setDVGeo(DVGeo)
+[p0, v1, v2] = DASolver.getTriangulatedMeshSurface(groupName=DASolver.getOption("designSurfaceFamily"))
+surf = [p0, v1, v2]
+DVCon.setSurface(surf)
+
+# optFuncs
+optFuncs.DASolver = DASolver
+optFuncs.DVGeo = DVGeo
+optFuncs.DVCon = DVCon
+optFuncs.evalFuncs = evalFuncs
+optFuncs.gcomm = gcomm
+
+
+def calcForwardADSens(forwardMethod):
+    """
+    Compute the forward-mode AD derivatives of CD and CL for all the design variables
+    using the given forwardMethod
+    """
+
+    funcsSens = {"CD": {}, "CL": {}}
+    for dvName in ["shape", "alpha", "pbc"]:
+        DASolver.setOption("useAD", {"dvName": dvName, "seedIndex": 0, "forwardMethod": forwardMethod})
+        DASolver.updateDAOption()
+        DASolver()
+        for funcName in funcsSens:
+            funcsSens[funcName][dvName] = DASolver.getForwardADDerivVal(funcName)
+
+    return funcsSens
+
+
+# differentiate the primal solver
+funcsSensPrimal = calcForwardADSens("primal")
+
+# solve the direct equation with the matrix-free dRdW and the reduced PC coloring
+funcsSensMatrixFree = calcForwardADSens("matrixFree")
+
+maxRelDiff = 0.0
+for funcName in funcsSensPrimal:
+    for dvName in funcsSensPrimal[funcName]:
+        ref = funcsSensPrimal[funcName][dvName]
+        new = funcsSensMatrixFree[funcName][dvName]
+        relDiff = abs(new - ref) / (abs(ref) + 1e-16)
+        maxRelDiff = max(maxRelDiff, relDiff)
+
+if gcomm.rank == 0:
+    reg_write_dict(funcsSensMatrixFree, 1e-4, 1e-5)
+    print("Max relative difference between the primal and matrix-free forward AD:")
+    print(maxRelDiff)
+    if maxRelDiff > 1e-5:
+        print("The matrix-free forward AD does not match the primal forward AD!")
+        exit(1)
@@ -0,0 +1,169 @@
+#!/usr/bin/env python
+"""
+Run Python tests for the finite-difference partials evaluated by multiple workers (adjPartDerivNWorkers)
+NOTE: the workers are only supported for serial runs so this test runs with one processor
+"""
+
+from mpi4py import MPI
+from dafoam import PYDAFOAM, optFuncs
+import sys
+import os
+from pygeo import *
+from pyspline import *
+from idwarp import *
+import numpy as np
+from petsc4py import PETSc
+from testFuncs import *
+
+gcomm = MPI.COMM_WORLD
+
+os.chdir("./input/NACA0012")
+
+if gcomm.rank == 0:
+    os.system("rm -rf 0 processor* *.bin")
+    os.system("cp -r 0.incompressible 0")
+    os.system("cp -r system.incompressible system")
+    os.system("cp -r constant/turbulenceProperties.sst constant/turbulenceProperties")
+
+U0 = 10.0
+p0 = 0.0
+k0 = 0.18
+omega0 = 1225.0
+A0 = 0.1
+
+# test incompressible solvers
+aeroOptions = {
+    "solverName": "DASimpleFoam",
+    "designSurfaceFamily": "designSurface",
+    "useAD": {"mode": "fd"},
+    "designSurfaces": ["wing"],
+    "primalMinResTol": 1e-12,
+    "primalBC": {
+        "U0": {"variable": "U", "patches": ["inout"], "value": [U0, 0.0, 0.0]},
+        "p0": {"variable": "p", "patches": ["inout"], "value": [p0]},
+        "k0": {"variable": "k", "patches": ["inout"], "value": [k0]},
+        "omega0": {"variable": "omega", "patches": ["inout"], "value": [omega0]},
+        "useWallFunction": False,
+    },
+    "objFunc": {
+        "CD": {
+            "part1": {
+                "type": "force",
+                "source": "patchToFace",
+                "patches": ["wing"],
+                "directionMode": "fixedDirection",
+                "direction": [1.0, 0.0, 0.0],
+                "scale": 1.0 / (0.5 * U0 * U0 * A0),
+                "addToAdjoint": True,
+            }
+        },
+    },
+    "normalizeStates": {"U": U0, "p": U0 * U0 / 2.0, "k": k0, "omega": omega0, "phi": 1.0},
+    "adjPartDerivFDStep": {"State": 1e-6, "FFD": 1e-3},
+    "adjEqnOption": {"gmresRelTol": 1.0e-10, "gmresAbsTol": 1.0e-15, "pcFillLevel": 1, "jacMatReOrdering": "natural"},
+    "adjPartDerivNWorkers": 1,
+    "writeJacobians": ["dRdWT", "dFdW", "dRdFFD"],
+    # Design variable setup
+    "designVar": {"shapey": {"designVarType": "FFD"}},
+}
+
+# mesh warping parameters, users need to manually specify the symmetry plane
+meshOptions = {
+    "gridFile": os.getcwd(),
+    "fileType": "OpenFOAM",
+    # point and normal for the symmetry plane
+    "symmetryPlanes": [[[0.0, 0.0, 0.0], [0.0, 0.0, 1.0]], [[0.0, 0.0, 0.1], [0.0, 0.0, 1.0]]],
+}
+
+# DVGeo
+FFDFile = "./FFD/wingFFD.xyz"
+DVGeo = DVGeometry(FFDFile)
+DVGeo.addRefAxis("bodyAxis", xFraction=0.25, alignIndex="k")
+# select points
+pts = DVGeo.getLocalIndex(0)
+indexList = pts[1:4, 1, 0].flatten()
+PS = geo_utils.PointSelect("list", indexList)
+DVGeo.addLocalDV("shapey", lower=-1.0, upper=1.0, axis="y", scale=1.0, pointSelect=PS)
+
+# DAFoam
+DASolver = PYDAFOAM(options=aeroOptions, comm=gcomm)
+DASolver.setDVGeo(DVGeo)
+mesh = USMesh(options=meshOptions, comm=gcomm)
+DASolver.addFamilyGroup(DASolver.getOption("designSurfaceFamily"), DASolver.getOption("designSurfaces"))
+DASolver.printFamilyList()
+DASolver.setMesh(mesh)
+# set evalFuncs
+evalFuncs = ["CD"]
+DASolver.setEvalFuncs(evalFuncs)
+
+# DVCon
+DVCon = DVConstraints()
+DVCon.setDVGeo(DVGeo)
+[p0, v1, v2] = DASolver.getTriangulatedMeshSurface(groupName=DASolver.getOption("designSurfaceFamily"))
+surf = [p0, v1, v2]
+DVCon.setSurface(surf)
+
+# optFuncs
+optFuncs.DASolver = DASolver
+optFuncs.DVGeo = DVGeo
+optFuncs.DVCon = DVCon
+optFuncs.evalFuncs = evalFuncs
+optFuncs.gcomm = gcomm
+
+# the partial derivative matrices written by the adjoint
+matNames = ["dRdWT", "dRdWTPC", "dRdFFD_shapey"]
+vecNames = ["dFdW_CD"]
+
+# Run
+DASolver.runColoring()
+xDVs = DVGeo.getValues()
+funcs, fail = optFuncs.calcObjFuncValues(xDVs)
+
+# the serial loop
+funcsSens, fail = optFuncs.calcObjFuncSens(xDVs, funcs)
+if gcomm.rank == 0:
+    for name in matNames + vecNames:
+        os.system("mv %s.bin %sSerial.bin" % (name, name))
+gcomm.Barrier()
+
+# three workers, the partials should be bit-identical to the serial loop
+DASolver.setOption("adjPartDerivNWorkers", 3)
+DASolver.updateDAOption()
+funcsSensWorkers, fail = optFuncs.calcObjFuncSens(xDVs, funcs)
+
+
+def readPetscObj(fileName, isMat):
+    viewer = PETSc.Viewer().createBinary(fileName, comm=PETSc.COMM_WORLD)
+    if isMat:
+        obj = PETSc.Mat().create(PETSc.COMM_WORLD)
+    else:
+        obj = PETSc.Vec().create(PETSc.COMM_WORLD)
+    obj.load(viewer)
+    return obj
+
+
+nDiffs = 0
+for name in matNames + vecNames:
+    isMat = name in matNames
+    objSerial = readPetscObj("%sSerial.bin" % name, isMat)
+    objWorkers = readPetscObj("%s.bin" % name, isMat)
+    if not objSerial.equal(objWorkers):
+        nDiffs += 1
+        if gcomm.rank == 0:
+            print("%s computed by the workers differs from the serial one!" % name)
+
+maxAbsDiff = 0.0
+for funcName in evalFuncs:
+    for dvName in xDVs:
+        ref = np.asarray(funcsSens[funcName][dvName])
+        new = np.asarray(funcsSensWorkers[funcName][dvName])
+        maxAbsDiff = max(maxAbsDiff, np.max(np.abs(new - ref)))
+
+if gcomm.rank == 0:
+    print("Number of partials that differ between the workers and the serial loop:")
+    reg_write(nDiffs, 1e-10, 1e-12)
+    print("Max absolute difference of the derivatives between the workers and the serial loop:")
+    reg_write(maxAbsDiff, 1e-10, 1e-12)
+    if nDiffs > 0 or maxAbsDiff > 0.0:
+        print("The workers do not match the serial loop!")
+        exit(1)
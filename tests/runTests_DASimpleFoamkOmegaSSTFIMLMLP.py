@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+"""
+Run Python tests for the mlp backend of the kOmegaSSTFIML model
+"""
+
+from mpi4py import MPI
+from dafoam import PYDAFOAM
+from testFuncs import *
+
+os.chdir("./input/PeriodicHill")
+
+gcomm = MPI.COMM_WORLD
+
+if gcomm.rank == 0:
+    os.system("rm -rf processor*")
+    # export the weights in kOmegaSSTFIML.pb to kOmegaSSTFIML.mlp for the mlp backend,
+    # the exporter reads the frozen graph without TensorFlow
+    if os.system("python ../../../dafoam/scripts/dafoam_exportmlp.py kOmegaSSTFIML.pb kOmegaSSTFIML.mlp") != 0:
+        print("Failed to export kOmegaSSTFIML.pb!")
+        exit(1)
+gcomm.Barrier()
+
+
+# the same setup as runTests_DASimpleFoamkOmegaSSTFIML.py but with the mlp backend
+aeroOptions = {
+    "solverName": "DASimpleFoam",
+    "useAD": {"mode": "fd"},
+    "primalMinResTol": 1e-3,
+    "fimlModel": {"backend": "mlp"},
+    "objFunc": {
+        "CD": {
+            "part1": {
+                "type": "force",
+                "source": "patchToFace",
+                "patches": ["bottomWall"],
+                "directionMode": "fixedDirection",
+                "direction": [1.0, 0.0, 0.0],
+                "scale": 1000.0,
+                "addToAdjoint": True,
+            }
+        },
+        "CL": {
+            "part1": {
+                "type": "force",
+                "source": "patchToFace",
+                "patches": ["bottomWall"],
+                "directionMode": "fixedDirection",
+                "direction": [0.0, 1.0, 0.0],
+                "scale": 1000.0,
+                "addToAdjoint": True,
+            }
+        },
+    },
+    "fvSource": {
+        "gradP": {
+            "type": "uniformPressureGradient",
+            "value": 6.8685e-06,
+            "direction": [1.0, 0.0, 0.0],
+        }
+    },
+}
+
+# DAFoam
+DASolver = PYDAFOAM(options=aeroOptions, comm=gcomm)
+DASolver()
+
+funcs = {}
+DASolver.evalFunctions(funcs, evalFuncs=["CD", "CL"])
+if gcomm.rank == 0:
+    # the reference values are the same as DAFoam_Test_DASimpleFoamkOmegaSSTFIMLRef.txt. The mlp
+    # backend evaluates the exported weights in double precision while the tensorflow graph uses
+    # single precision, so we allow a small difference
+    reg_write_dict(funcs, 1e-5, 1e-8)